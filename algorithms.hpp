@@ -2,6 +2,9 @@
 
 #include "basics.hpp"
 
+#include <array>
+#include <utility>
+
 // Transform
 
 template<class, template<class> class>
@@ -153,6 +156,92 @@ static_assert(std::is_same_v<ConcatLists<TypeList<>, TypeList<float, char>>, Typ
 static_assert(std::is_same_v<ConcatLists<TypeList<bool, int>, TypeList<>>, TypeList<bool, int>>, "");
 static_assert(std::is_same_v<ConcatLists<TypeList<bool>, TypeList<int>, TypeList<float, char>>, TypeList<bool, int, float, char>>, "");
 
+// ElementAt
+// NthElement through one overload resolution against bases indexed by position instead of one instantiation
+// per preceding element, so looking up every element of a list costs linear rather than quadratic time
+
+template<int Ind, class T>
+struct IndexedElement {
+	using Type = T;
+};
+
+template<class List, class Inds = std::make_integer_sequence<int, ListSize<List>::value>>
+struct IndexedElements;
+
+template<template<class...> class List, class... Ts, int... Inds>
+struct IndexedElements<List<Ts...>, std::integer_sequence<int, Inds...>> : IndexedElement<Inds, Ts>... {};
+
+template<int Ind, class T>
+IndexedElement<Ind, T> indexedElement(const IndexedElement<Ind, T>&);
+
+template<class List, int Ind>
+using ElementAt = typename decltype(indexedElement<Ind>(std::declval<IndexedElements<List>>()))::Type;
+
+static_assert(std::is_same_v<ElementAt<TypeList<int, bool, int>, 2>, int>, "");
+static_assert(std::is_same_v<ElementAt<ValueList<int, 4, 5>, 1>, Value<int, 5>>, "");
+static_assert(std::is_same_v<ElementAt<std::tuple<char, float>, 1>, float>, "");
+
+// Flatten
+// concatenates every list of Lists onto Init by pairwise tree reduction. A fold expression pushes the lists onto
+// a stack of blocks and, like incrementing a binary counter, merges the top two blocks while they hold the same
+// number of lists. Every element is copied once per level of the tree, O(n log n) in total, at constant depth
+
+template<class>
+struct FlattenTag {};
+
+template<template<class...> class List1, template<class...> class List2, class... Types1, class... Types2>
+FlattenTag<List1<Types1..., Types2...>> operator+(FlattenTag<List1<Types1...>>, FlattenTag<List2<Types2...>>);
+
+template<int Level, class List>
+struct FlattenBlock {};
+
+template<class... Blocks>
+struct FlattenStack {};
+
+template<class Stack, class Block>
+struct FlattenPushT;
+
+template<class... Blocks, class Block>
+struct FlattenPushT<FlattenStack<Blocks...>, Block> {
+	using Type = FlattenStack<Block, Blocks...>;
+};
+
+template<int Level, class List1, class List2, class... Blocks>
+struct FlattenPushT<FlattenStack<FlattenBlock<Level, List1>, Blocks...>, FlattenBlock<Level, List2>>
+	: FlattenPushT<FlattenStack<Blocks...>, FlattenBlock<Level + 1, ConcatLists<List1, List2>>>
+{};
+
+template<class... Blocks, class List>
+typename FlattenPushT<FlattenStack<Blocks...>, FlattenBlock<0, List>>::Type operator+(FlattenStack<Blocks...>, FlattenTag<List>);
+
+template<class, class>
+struct FlattenT;
+
+template<template<class...> class Outer, class... Lists, class Init>
+struct FlattenT<Outer<Lists...>, Init> {
+private:
+	template<class... Tags>
+	static auto concat(TypeList<Tags...>) -> decltype((Tags{} + ...));
+
+	// the stack holds the newest block first, Init sits at the bottom on a level no block reaches
+	template<int... Levels, class... Blocks>
+	static auto unwind(FlattenStack<FlattenBlock<Levels, Blocks>...>) -> decltype(concat(Reverse<TypeList<FlattenTag<Blocks>...>>{}));
+
+	template<class List>
+	static List unwrap(FlattenTag<List>);
+
+public:
+	using Type = decltype(unwrap(unwind((FlattenStack<FlattenBlock<-1, Init>>{} + ... + FlattenTag<Lists>{}))));
+};
+
+template<class Lists, class Init = TypeList<>>
+using Flatten = typename FlattenT<Lists, Init>::Type;
+
+static_assert(std::is_same_v<Flatten<TypeList<>>, TypeList<>>, "");
+static_assert(std::is_same_v<Flatten<TypeList<TypeList<int>, TypeList<>, TypeList<float, char>>>, TypeList<int, float, char>>, "");
+static_assert(std::is_same_v<Flatten<TypeList<std::tuple<int>, std::tuple<bool>>, std::tuple<>>, std::tuple<int, bool>>, "");
+static_assert(std::is_same_v<Flatten<TypeList<ValueList<int, 1>, ValueList<int, 2, 3>>, ValueList<int>>, ValueList<int, 1, 2, 3>>, "");
+
 // JoinLists
 
 template<class...>
@@ -282,26 +371,20 @@ static_assert(IsEven::apply(Value<int, 2>{}) == true, "");
 
 // Filter
 
-template<class List, class FilterFunc, class Result = EmptyList<List>>
-struct FilterT {
-	using Type = typename FilterT<PopFront<List>, FilterFunc, 
-		IfThenElse<
-			FilterFunc::apply(Front<List>{}),
-			PushBack<Result, Front<List>>,
-			Result
-		>
-	>::Type;
-};
+template<class, class>
+struct FilterT;
 
-template<template<class...> class List, class Func, class Result>
-struct FilterT<List<>, Func, Result> {
-	using Type = Result;
+template<template<class...> class List, class FilterFunc, class... Ts>
+struct FilterT<List<Ts...>, FilterFunc> {
+	using Type = Flatten<TypeList<IfThenElse<FilterFunc::apply(Ts{}), List<Ts>, List<>>...>, List<>>;
 };
 
 template<class List, class FilterFunc>
 using Filter = typename FilterT<List, FilterFunc>::Type;
 
 static_assert(std::is_same_v<Filter<ValueList<int, 1, 3, 4, 5, 6, 2>, IsEven>, ValueList<int, 4, 6, 2>>, "");
+static_assert(std::is_same_v<Filter<ValueList<int, 1, 3>, IsEven>, ValueList<int>>, "");
+static_assert(std::is_same_v<Filter<ValueList<int>, IsEven>, ValueList<int>>, "");
 
 // Not
 
@@ -330,9 +413,9 @@ struct LessEq;
 
 template<class T, int I>
 struct LessEq<Value<T, I>> {
-	template<class T2, T2 I>
-	static constexpr bool apply(Value<T2, I>) {
-		return apply(I);
+	template<class T2, T2 I2>
+	static constexpr bool apply(Value<T2, I2>) {
+		return apply(I2);
 	}
 
 	template<class T2>
@@ -446,3 +529,120 @@ static_assert(std::is_same_v<MergeSort<ValueList<int, 4, 3>>, ValueList<int, 3,
 static_assert(std::is_same_v<MergeSort<ValueList<int, 1, 4, 3>>, ValueList<int, 1, 3, 4>>, "");
 static_assert(std::is_same_v<MergeSort<ValueList<int, 4, 3, -1, 5, 2, -2>>, ValueList<int, -2, -1, 2, 3, 4, 5>>, "");
 
+
+// IndexOf
+
+template<class Sought, class List, int Ind = 0>
+struct IndexOf;
+
+template<class Sought, template<class...> class List, int Ind>
+struct IndexOf<Sought, List<>, Ind> {
+	static constexpr int value = -1;
+};
+
+template<class Sought, template<class...> class List, int Ind, class Head, class... Tail>
+struct IndexOf<Sought, List<Head, Tail...>, Ind> {
+	static constexpr int value = std::is_same_v<Sought, Head> ? Ind : IndexOf<Sought, List<Tail...>, Ind + 1>::value;
+};
+
+static_assert(IndexOf<int, TypeList<>>::value == -1, "");
+static_assert(IndexOf<int, TypeList<int, float>>::value == 0, "");
+static_assert(IndexOf<float, TypeList<int, float>>::value == 1, "");
+static_assert(IndexOf<char, TypeList<int, float>>::value == -1, "");
+static_assert(IndexOf<Value<int, 3>, ValueList<int, 1, 3, 3>>::value == 1, "");
+
+// ZipWith
+// Transform over several lists of equal size, Func gets one element of every list
+
+template<template<class...> class Func, class Args>
+struct ApplyT;
+
+template<template<class...> class Func, template<class...> class List, class... Args>
+struct ApplyT<Func, List<Args...>> : Func<Args...> {};
+
+template<class Zipped, class... Lists>
+struct ZipListsT {
+	using Type = Zipped;
+};
+
+template<template<class...> class Outer, class... Zipped, template<class...> class List, class... Ts, class... Lists>
+struct ZipListsT<Outer<Zipped...>, List<Ts...>, Lists...> : ZipListsT<Outer<PushBack<Zipped, Ts>...>, Lists...> {};
+
+template<template<class...> class Func, class... Lists>
+struct ZipWithT;
+
+template<template<class...> class Func, template<class...> class List, class... Ts, class... Lists>
+struct ZipWithT<Func, List<Ts...>, Lists...> {
+	static_assert(((ListSize<Lists>::value == sizeof...(Ts)) && ...), "ZipWith lists must have the same size");
+
+private:
+	template<class... Zipped>
+	static List<typename ApplyT<Func, Zipped>::Type...> apply(TypeList<Zipped...>);
+
+public:
+	using Type = decltype(apply(typename ZipListsT<TypeList<TypeList<Ts>...>, Lists...>::Type{}));
+};
+
+template<template<class...> class Func, class... Lists>
+using ZipWith = typename ZipWithT<Func, Lists...>::Type;
+
+static_assert(std::is_same_v<ZipWith<AddPointer, TypeList<int, double>>, TypeList<int*, double*>>, "");
+static_assert(std::is_same_v<ZipWith<LargerTypeT, TypeList<>, TypeList<>>, TypeList<>>, "");
+static_assert(std::is_same_v<ZipWith<LargerTypeT, TypeList<char, double>, TypeList<short, int>>, TypeList<short, double>>, "");
+static_assert(std::is_same_v<ZipWith<LargerValueT, ValueList<int, 1, 5, 3>, ValueList<int, 4, 2, 3>>, ValueList<int, 4, 5, 3>>, "");
+static_assert(std::is_same_v<ZipWith<LargerTypeT, std::tuple<char, int>, TypeList<short, char>>, std::tuple<short, int>>, "");
+
+// CartesianProduct
+// a TypeList holding a TypeList for every combination, the first list varies slowest. Combination i picks
+// element (i / stride) % size of every list with ElementAt, so the cost is linear in the size of the product
+
+template<class... Lists>
+struct CartesianProductT {
+private:
+	static constexpr int numLists = static_cast<int>(sizeof...(Lists));
+	static constexpr int size = (1 * ... * ListSize<Lists>::value);
+
+	static constexpr std::array<int, numLists> findStrides() {
+		constexpr int sizes[] = { ListSize<Lists>::value..., 1 };
+		std::array<int, numLists> strides{};
+		int stride = 1;
+		for (int list = numLists - 1; list >= 0; --list) {
+			strides[list] = stride;
+			stride *= sizes[list];
+		}
+		return strides;
+	}
+
+	static constexpr std::array<int, numLists> strides = findStrides();
+
+	template<int Combination, int... ListInds>
+	static TypeList<ElementAt<Lists, Combination / strides[ListInds] % ListSize<Lists>::value>...> combination(std::integer_sequence<int, ListInds...>);
+
+	template<int... Combinations>
+	static TypeList<decltype(combination<Combinations>(std::make_integer_sequence<int, numLists>{}))...> expand(std::integer_sequence<int, Combinations...>);
+
+public:
+	using Type = decltype(expand(std::make_integer_sequence<int, size>{}));
+};
+
+template<class... Lists>
+using CartesianProduct = typename CartesianProductT<Lists...>::Type;
+
+static_assert(std::is_same_v<CartesianProduct<>, TypeList<TypeList<>>>, "");
+static_assert(std::is_same_v<CartesianProduct<TypeList<int, float>>, TypeList<TypeList<int>, TypeList<float>>>, "");
+static_assert(std::is_same_v<CartesianProduct<TypeList<int, float>, TypeList<>>, TypeList<>>, "");
+static_assert(std::is_same_v<CartesianProduct<TypeList<int, float>, std::tuple<char, bool>>,
+	TypeList<TypeList<int, char>, TypeList<int, bool>, TypeList<float, char>, TypeList<float, bool>>>, "");
+static_assert(ListSize<CartesianProduct<TypeList<int, float>, ValueList<int, 1, 2, 4>, TypeList<char, bool>>>::value == 12, "");
+
+namespace {
+	struct TestSameSize {
+		template<class T1, class T2>
+		static constexpr bool apply(TypeList<T1, T2>) {
+			return sizeof(T1) == sizeof(T2);
+		}
+	};
+}
+
+static_assert(std::is_same_v<Filter<CartesianProduct<TypeList<int, double>, TypeList<float, long long>>, TestSameSize>,
+	TypeList<TypeList<int, float>, TypeList<double, long long>>>, "");
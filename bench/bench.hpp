@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+// escape
+// makes the compiler assume the pointed-to memory is read, so benchmarked stores aren't dropped
+
+inline void escape(const void* p) {
+#if defined(_MSC_VER)
+	static const void* volatile sink;
+	sink = p;
+#else
+	asm volatile("" : : "g"(p) : "memory");
+#endif
+}
+
+// measure
+// runs func reps times and returns the average nanoseconds per item
+
+template<class Func>
+double measure(int reps, long long items, Func func) {
+	func();
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < reps; ++i) {
+		func();
+	}
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / reps / static_cast<double>(items);
+}
+
+inline void report(const char* name, double nsPerItem) {
+	std::printf("%-40s %8.3f ns\n", name, nsPerItem);
+}
@@ -0,0 +1,59 @@
+// Bucketing against std::lower_bound over the same sorted thresholds
+// build: c++ -std=c++17 -O3 -march=native -I. bench/bucketing.cpp -o bench_bucketing
+
+#include "bench.hpp"
+#include "bucketing.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using Thresholds7 = ValueList<int, 1000, 10, 100000, 100, 10000000, 1000000, 100000000>;
+using Thresholds31 = ValueList<int, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000,
+	100000, 200000, 500000, 1000000, 2000000, 5000000, 10000000, 20000000, 50000000, 100000000,
+	200000000, 500000000, 1000000000, 1500000000, 2000000000, 7, 3, 60>;
+
+template<class Thresholds>
+void run(const char* name) {
+	using B = Bucketing<Thresholds>;
+	constexpr auto sorted = ToArrayT<SortList<Thresholds>>::value;
+
+	// keys spread over all magnitudes so that every bucket is hit
+	std::mt19937 gen(1);
+	std::vector<int> keys(1 << 20);
+	for (auto& key : keys) {
+		key = static_cast<int>(gen() >> 1) >> (gen() % 31);
+	}
+	std::vector<int> expected(keys.size()), buckets(keys.size());
+	for (std::size_t i = 0; i < keys.size(); ++i) {
+		expected[i] = static_cast<int>(std::lower_bound(sorted.begin(), sorted.end(), keys[i]) - sorted.begin());
+	}
+
+	const std::string prefix = std::string(name) + " ";
+	report((prefix + "std::lower_bound").c_str(), measure(20, keys.size(), [&] {
+		for (std::size_t i = 0; i < keys.size(); ++i) {
+			buckets[i] = static_cast<int>(std::lower_bound(sorted.begin(), sorted.end(), keys[i]) - sorted.begin());
+		}
+		escape(buckets.data());
+	}));
+	report((prefix + "Bucketing").c_str(), measure(20, keys.size(), [&] {
+		for (std::size_t i = 0; i < keys.size(); ++i) {
+			buckets[i] = B::lowerBound(keys[i]);
+		}
+		escape(buckets.data());
+	}));
+	report((prefix + "Bucketing batch").c_str(), measure(20, keys.size(), [&] {
+		B::lowerBound(keys.data(), buckets.data(), keys.size());
+		escape(buckets.data());
+	}));
+	if (buckets != expected) {
+		std::printf("%s: Bucketing disagrees with std::lower_bound\n", name);
+	}
+}
+
+int main() {
+	run<Thresholds7>("7 thresholds");
+	run<Thresholds31>("31 thresholds");
+}
@@ -0,0 +1,84 @@
+// overhead of Instrumented against the unwrapped call and a bare steady_clock::now()
+// build: c++ -std=c++17 -O3 -march=native -I. bench/instrumented.cpp -o bench_instrumented -pthread
+
+#include "bench.hpp"
+#include "instrumented.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#if defined(_MSC_VER)
+__declspec(noinline)
+#else
+__attribute__((noinline))
+#endif
+int work(int x) {
+	return x * 3 + 1;
+}
+
+int main() {
+	constexpr int calls = 1 << 22;
+	auto plain = [](int x) { return work(x); };
+	Instrumented<decltype(plain)> wrapped(plain);
+
+	int sum = 0;
+	const double plainNs = measure(5, calls, [&] {
+		for (int i = 0; i < calls; ++i) {
+			sum += plain(i);
+		}
+		escape(&sum);
+	});
+	const double wrappedNs = measure(5, calls, [&] {
+		for (int i = 0; i < calls; ++i) {
+			sum += wrapped(i);
+		}
+		escape(&sum);
+	});
+	const double nowNs = measure(5, calls, [&] {
+		for (int i = 0; i < calls; ++i) {
+			const auto now = std::chrono::steady_clock::now();
+			escape(&now);
+		}
+	});
+	report("unwrapped call", plainNs);
+	report("Instrumented call", wrappedNs);
+	report("steady_clock::now()", nowNs);
+	report("overhead per call", wrappedNs - plainNs);
+
+	// every thread records into its own histogram, so with a core per thread the cost of a call stays the same
+	const unsigned numThreads = std::max(std::thread::hardware_concurrency(), 2u);
+	Instrumented<decltype(plain)> shared(plain);
+	const double threadedNs = measure(1, static_cast<long long>(numThreads) * calls, [&] {
+		std::vector<std::thread> threads;
+		for (unsigned t = 0; t < numThreads; ++t) {
+			threads.emplace_back([&shared] {
+				int threadSum = 0;
+				for (int i = 0; i < calls; ++i) {
+					threadSum += shared(i);
+				}
+				escape(&threadSum);
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	});
+	std::printf("%-40s %8.3f ns (%u threads)\n", "Instrumented call, concurrent", threadedNs, numThreads);
+
+	const LatencyReport latencies = wrapped.snapshot();
+	std::printf("calls %llu, p50 %llu ns, p99 %llu ns, p99.9 %llu ns, max %llu ns\n",
+		static_cast<unsigned long long>(latencies.calls),
+		static_cast<unsigned long long>(latencies.percentile(50.0)),
+		static_cast<unsigned long long>(latencies.percentile(99.0)),
+		static_cast<unsigned long long>(latencies.percentile(99.9)),
+		static_cast<unsigned long long>(latencies.max()));
+
+	const unsigned long long expected = 6ull * calls;
+	if (latencies.calls != expected || shared.snapshot().calls != 2ull * numThreads * calls) {
+		std::printf("Instrumented lost calls\n");
+		return 1;
+	}
+}
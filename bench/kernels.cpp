@@ -0,0 +1,82 @@
+// constant-coefficient kernels against the same kernels with runtime coefficients
+// build: c++ -std=c++17 -O3 -march=native -I. bench/kernels.cpp -o bench_kernels
+
+#include "bench.hpp"
+#include "kernels.hpp"
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+using FirCoeffs = ValueList<int, 1, 0, 4, 0, 6, 0, 4, 0, 1>;
+using PolyCoeffs = ValueList<int, 3, 0, -2, 0, 1, 1>;
+
+template<class T>
+void firRuntime(const int* coeffs, int numCoeffs, int scale, const T* in, T* out, std::size_t size) {
+	for (std::size_t i = 0; i < size; ++i) {
+		T sum = 0;
+		for (int k = 0; k < numCoeffs; ++k) {
+			sum += T(coeffs[k]) * in[i + k];
+		}
+		out[i] = sum / T(scale);
+	}
+}
+
+template<class T>
+void polynomialRuntime(const int* coeffs, int numCoeffs, const T* in, T* out, std::size_t size) {
+	for (std::size_t i = 0; i < size; ++i) {
+		T res = T(coeffs[numCoeffs - 1]);
+		for (int k = numCoeffs - 2; k >= 0; --k) {
+			res = res * in[i] + T(coeffs[k]);
+		}
+		out[i] = res;
+	}
+}
+
+template<class T>
+void run(const char* type) {
+	constexpr std::size_t size = 1 << 16;
+	// volatile so the compiler can't fold the runtime coefficients
+	static volatile int firCoeffs[] = { 1, 0, 4, 0, 6, 0, 4, 0, 1 };
+	static volatile int polyCoeffs[] = { 3, 0, -2, 0, 1, 1 };
+	int fir9[9];
+	int poly6[6];
+	for (int i = 0; i < 9; ++i) fir9[i] = firCoeffs[i];
+	for (int i = 0; i < 6; ++i) poly6[i] = polyCoeffs[i];
+	const int* firRt = fir9;
+	const int* polyRt = poly6;
+
+	std::mt19937 gen(1);
+	std::uniform_real_distribution<double> dist(-1.0, 1.0);
+	std::vector<T> in(size + 8), out(size);
+	for (auto& v : in) {
+		v = T(dist(gen));
+	}
+
+	std::printf("%s\n", type);
+	report("fir constant", measure(200, size, [&] { fir<FirCoeffs, 16>(in.data(), out.data(), size); escape(out.data()); }));
+	report("fir runtime", measure(200, size, [&] { firRuntime(firRt, 9, 16, in.data(), out.data(), size); escape(out.data()); }));
+	report("polynomial constant", measure(200, size, [&] { polynomial<PolyCoeffs>(in.data(), out.data(), size); escape(out.data()); }));
+	report("polynomial runtime", measure(200, size, [&] { polynomialRuntime(polyRt, 6, in.data(), out.data(), size); escape(out.data()); }));
+
+	volatile T sink = 0;
+	report("dotProduct constant", measure(200, size, [&] {
+		T sum = 0;
+		for (std::size_t i = 0; i < size; ++i) sum += dotProduct<FirCoeffs>(in.data() + i);
+		sink = sum;
+	}));
+	report("dotProduct runtime", measure(200, size, [&] {
+		T sum = 0;
+		for (std::size_t i = 0; i < size; ++i) {
+			T dot = 0;
+			for (int k = 0; k < 9; ++k) dot += T(firRt[k]) * in[i + k];
+			sum += dot;
+		}
+		sink = sum;
+	}));
+}
+
+int main() {
+	run<float>("float");
+	run<double>("double");
+}
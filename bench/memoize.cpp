@@ -0,0 +1,141 @@
+// checks LruCache eviction order, ShardedLruCache capacity splitting and how often Memoize and MemoizePure
+// call the wrapped function, returns 1 if any check fails
+// build: c++ -std=c++17 -O2 -I. bench/memoize.cpp -o bench_memoize -pthread
+
+#include "memoize.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+	if (!ok) {
+		std::printf("FAILED: %s\n", what);
+		++failures;
+	}
+}
+
+void checkLruCache() {
+	LruCache<int, int, std::hash<int>> cache(3);
+	cache.insert(1, 10);
+	cache.insert(2, 20);
+	cache.insert(3, 30);
+	check(cache.find(1) == 10, "LruCache finds an inserted key");
+
+	// 1 was used last, so 2 is the least recently used key
+	cache.insert(4, 40);
+	check(!cache.find(2), "LruCache evicts the least recently used key");
+	check(cache.find(1) && cache.find(3) && cache.find(4), "LruCache keeps the other keys");
+
+	// inserting an existing key updates it and makes it the most recently used
+	cache.insert(3, 31);
+	cache.insert(1, 11);
+	cache.insert(5, 50);
+	check(!cache.find(4), "LruCache evicts the key not touched since");
+	check(cache.find(3) == 31 && cache.find(1) == 11, "LruCache updates an existing key");
+}
+
+void checkShardedLruCache() {
+	using Key = std::tuple<int>;
+	constexpr std::size_t numShards = 4;
+
+	// keys landing in shard 0, found the same way the cache picks a shard
+	std::vector<Key> keys;
+	for (int i = 0; keys.size() < 4; ++i) {
+		if (mixHash(TupleHash{}(Key(i))) % numShards == 0) {
+			keys.emplace_back(i);
+		}
+	}
+
+	// a capacity of 10 over 4 shards gives every shard room for 3 keys
+	ShardedLruCache<Key, int> cache(10, numShards);
+	for (int i = 0; i < 3; ++i) {
+		cache.insert(keys[i], i);
+	}
+	check(cache.find(keys[0]) && cache.find(keys[1]) && cache.find(keys[2]), "ShardedLruCache rounds the shard capacity up");
+	cache.insert(keys[3], 3);
+	check(!cache.find(keys[0]), "ShardedLruCache evicts within a full shard");
+
+	// keys of other shards don't evict from shard 0
+	int inserted = 0;
+	for (int i = 0; inserted < 9; ++i) {
+		if (mixHash(TupleHash{}(Key(i))) % numShards != 0) {
+			cache.insert(Key(i), i);
+			++inserted;
+		}
+	}
+	check(cache.find(keys[1]) && cache.find(keys[2]) && cache.find(keys[3]), "ShardedLruCache shards evict independently");
+}
+
+void checkMemoize() {
+	std::atomic<int> calls{ 0 };
+	Memoize memoized([&calls](const std::string& str, int times) {
+		++calls;
+		return str.size() * static_cast<std::size_t>(times);
+	}, 4, 1);
+
+	const std::string abc = "abc";
+	check(memoized(abc, 2) == 6 && memoized(abc, 2) == 6 && memoized(std::string("abc"), 2) == 6, "Memoize returns the function's result");
+	check(calls == 1, "Memoize calls the function once per key");
+
+	for (int i = 0; i < 4; ++i) {
+		memoized("x", i);
+	}
+	calls = 0;
+	memoized(abc, 2);
+	check(calls == 1, "Memoize calls the function again once its key was evicted");
+}
+
+void checkMemoizePure() {
+	constexpr int min = 0;
+	constexpr int max = 1023;
+	static std::array<std::atomic<int>, max + 2> calls{};
+
+	// arguments above max aren't cached and are counted in the last slot
+	MemoizePure<int (*)(int), min, max> square(+[](int x) {
+		++calls[static_cast<std::size_t>(x <= max ? x : max + 1)];
+		return x * x;
+	});
+
+	constexpr int numThreads = 8;
+	constexpr int outside = 100;
+	std::atomic<bool> correct{ true };
+	std::vector<std::thread> threads;
+	for (int t = 0; t < numThreads; ++t) {
+		threads.emplace_back([&square, &correct] {
+			for (int i = min; i <= max + outside; ++i) {
+				if (square(i) != i * i) {
+					correct = false;
+				}
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	check(correct, "MemoizePure returns the function's result");
+	bool once = true;
+	for (int i = min; i <= max; ++i) {
+		once = once && calls[static_cast<std::size_t>(i)] == 1;
+	}
+	check(once, "MemoizePure calls the function once per slot");
+	check(calls[max + 1] == numThreads * outside, "MemoizePure calls the function every time outside its range");
+}
+
+int main() {
+	checkLruCache();
+	checkShardedLruCache();
+	checkMemoize();
+	checkMemoizePure();
+	if (failures == 0) {
+		std::printf("all memoize checks passed\n");
+	}
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+// sorting networks against std::sort and insertion sort on many small arrays
+// build: c++ -std=c++17 -O3 -march=native -I. bench/sorting.cpp -o bench_sorting
+
+#include "bench.hpp"
+#include "sorting.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+template<class T, std::size_t N>
+void insertionSort(std::array<T, N>& arr) {
+	for (std::size_t i = 1; i < N; ++i) {
+		const T v = arr[i];
+		std::size_t j = i;
+		for (; j > 0 && v < arr[j - 1]; --j) {
+			arr[j] = arr[j - 1];
+		}
+		arr[j] = v;
+	}
+}
+
+template<class T, std::size_t N>
+void run(const char* type) {
+	constexpr std::size_t count = 1 << 12;
+	constexpr int reps = 50;
+
+	std::mt19937 gen(1);
+	std::vector<std::array<T, N>> input(count);
+	for (auto& arr : input) {
+		for (auto& v : arr) {
+			v = T(static_cast<int>(gen() % 100000) - 50000);
+		}
+	}
+	std::vector<std::array<T, N>> arrs;
+
+	// every repetition copies the unsorted input first, the copy is timed separately and subtracted
+	auto time = [&](auto sort) {
+		return measure(reps, count, [&] {
+			arrs = input;
+			sort();
+			escape(arrs.data());
+		});
+	};
+	const double copy = time([] {});
+
+	const std::string prefix = std::string(type) + " N=" + std::to_string(N) + " ";
+	report((prefix + "std::sort").c_str(), time([&] {
+		for (auto& arr : arrs) std::sort(arr.begin(), arr.end());
+	}) - copy);
+	report((prefix + "insertion sort").c_str(), time([&] {
+		for (auto& arr : arrs) insertionSort(arr);
+	}) - copy);
+	report((prefix + "sortNetwork").c_str(), time([&] {
+		for (auto& arr : arrs) sortNetwork(arr);
+	}) - copy);
+	report((prefix + "sortNetwork batch").c_str(), time([&] {
+		sortNetwork(arrs.data(), arrs.size());
+	}) - copy);
+}
+
+template<class T>
+void runSizes(const char* type) {
+	run<T, 4>(type);
+	run<T, 8>(type);
+	run<T, 16>(type);
+	run<T, 32>(type);
+}
+
+int main() {
+	runSizes<float>("float");
+	runSizes<std::int32_t>("int32");
+	runSizes<double>("double");
+}
@@ -0,0 +1,67 @@
+// translation unit for bench/symbols.sh: sorts lists with SortList, MergeSort and QuickSort and uses
+// the results at runtime, together with sorting networks and kernels of every size in use
+
+#include "kernels.hpp"
+#include "sorting.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <utility>
+
+using Unsorted = ValueList<int, 31, 7, 19, 3, 27, 11, 23, 1, 29, 5, 17, 9, 25, 13, 21, 15,
+	30, 6, 18, 2, 26, 10, 22, 0, 28, 4, 16, 8, 24, 12, 20, 14>;
+
+template<template<class...> class List, class T, T... Vals>
+constexpr std::array<T, sizeof...(Vals)> toArray(List<Value<T, Vals>...>) {
+	return { { Vals... } };
+}
+
+constexpr auto bySortList = toArray(SortList<Unsorted>{});
+constexpr auto byMergeSort = toArray(MergeSort<Unsorted>{});
+constexpr auto byQuickSort = toArray(QuickSort<Unsorted>{});
+
+template<std::size_t N>
+float sortFloats(const float* vals) {
+	std::array<float, N> arr;
+	std::copy_n(vals, N, arr.begin());
+	sortNetwork(arr);
+	return arr[N / 2];
+}
+
+template<std::size_t N>
+int sortInts(const int* vals) {
+	std::array<int, N> arrs[4];
+	for (std::size_t i = 0; i < 4; ++i) {
+		std::copy_n(vals + i * N, N, arrs[i].begin());
+	}
+	sortNetwork(arrs, 4);
+	return arrs[3][N / 2];
+}
+
+template<std::size_t... Ns>
+float sortAll(const float* floats, const int* ints, std::index_sequence<Ns...>) {
+	return (sortFloats<Ns + 2>(floats) + ...) + static_cast<float>((sortInts<Ns + 2>(ints) + ...));
+}
+
+int main(int argc, char**) {
+	static float floats[32 * 4];
+	static int ints[32 * 4];
+	static float out[100];
+	for (int i = 0; i < 32 * 4; ++i) {
+		ints[i] = (i * 37 + argc) % 101;
+		floats[i] = static_cast<float>(ints[i]);
+	}
+	const float medians = sortAll(floats, ints, std::make_index_sequence<31>{});
+
+	fir<ValueList<int, 1, 0, 2, 0, 1, 3, 0, 0, 5, 7, 1, 2, 0, 4, 4, 1>, 4>(floats, out, 100);
+	polynomial<ValueList<int, 1, 0, 2, 0, 1, 3, 0, 0, 5, 7, 1, 2>>(floats, out, 100);
+	const float dot = dotProduct<ValueList<int, 3, 0, 2, 9, 1, -1, 0, 2>>(floats);
+
+	int diff = 0;
+	for (std::size_t i = 0; i < bySortList.size(); ++i) {
+		diff += ints[i] * 3 - bySortList[i] - byMergeSort[i] - byQuickSort[i];
+	}
+
+	std::printf("%f %f %f %d\n", medians, out[99], dot, diff);
+}
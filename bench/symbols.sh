@@ -0,0 +1,53 @@
+#!/bin/sh
+# reports object size, symbol table size, number of symbols spelling out a TypeList and link time of bench/symbols.cpp
+# usage: bench/symbols.sh [rev]  (run from the repository root; with a rev, its headers are measured too)
+# CXX and CXXFLAGS are honoured, e.g. CXX=clang++ bench/symbols.sh HEAD~3
+
+set -e
+
+CXX=${CXX:-c++}
+CXXFLAGS=${CXXFLAGS:-}
+root=$(pwd)
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+
+milliseconds() {
+	date +%s%N | cut -c1-13
+}
+
+sectionSize() {
+	hex=$(readelf -SW "$1" | awk -v name="$2" '{ for (i = 1; i < NF; ++i) if ($i == name) { print $(i + 4); exit } }')
+	printf '%d' "0x${hex:-0}"
+}
+
+measure() {
+	label=$1
+	include=$2
+	for opt in -O0 -O2; do
+		obj="$work/$label$opt.o"
+		"$CXX" -std=c++17 $opt -g0 $CXXFLAGS -I"$include" -c "$root/bench/symbols.cpp" -o "$obj"
+		start=$(milliseconds)
+		for i in 1 2 3 4 5; do
+			"$CXX" "$obj" -o "$work/$label$opt"
+		done
+		link=$(( ($(milliseconds) - start) / 5 ))
+		printf '%-10s %-4s %10s %10s %10s %8s %8s %8s %8s\n' "$label" "$opt" \
+			"$(stat -c %s "$obj")" \
+			"$(sectionSize "$obj" .symtab)" \
+			"$(sectionSize "$obj" .strtab)" \
+			"$(nm "$obj" | wc -l)" \
+			"$(nm "$obj" | awk '{ n = length($NF); if (n > max) max = n } END { print max + 0 }')" \
+			"$(nm -C "$obj" | grep -c 'TypeList<' || true)" \
+			"$link"
+	done
+}
+
+printf '%-10s %-4s %10s %10s %10s %8s %8s %8s %8s\n' build opt ".o bytes" ".symtab" ".strtab" symbols longest TypeList "link ms"
+
+if [ -n "$1" ]; then
+	mkdir "$work/rev"
+	git archive "$1" -- '*.hpp' | tar -x -C "$work/rev"
+	measure "$1" "$work/rev"
+fi
+measure tree "$root"
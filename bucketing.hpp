@@ -0,0 +1,133 @@
+#pragma once
+
+#include "algorithms.hpp"
+
+#include <array>
+#include <cstddef>
+#include <limits>
+
+// ToArray
+
+template<class>
+struct ToArrayT;
+
+template<template<class...> class List, class T, T... Vals>
+struct ToArrayT<List<Value<T, Vals>...>> {
+	using ValueType = T;
+	static constexpr std::array<T, sizeof...(Vals)> value{ { Vals... } };
+};
+
+static_assert(ToArrayT<ValueList<int, 3, 1, 2>>::value[1] == 1, "");
+
+// Bucketing
+// lower_bound over fixed thresholds: Thresholds are sorted with SortList and laid out in Eytzinger (BFS) order,
+// padded with the largest value to a full tree so every search takes exactly `levels` branch-free steps.
+// A key is classified into bucket i when i thresholds are less than it, the same index std::lower_bound gives.
+
+template<class Thresholds>
+struct Bucketing {
+	static_assert(ListSize<Thresholds>::value > 0, "Bucketing needs at least one threshold");
+
+	using ValueType = typename ToArrayT<Thresholds>::ValueType;
+
+	static constexpr int size = ListSize<Thresholds>::value;
+
+private:
+	static constexpr int countLevels() {
+		int levels = 0;
+		while ((1 << levels) - 1 < size) {
+			++levels;
+		}
+		return levels;
+	}
+
+public:
+	static constexpr int levels = countLevels();
+
+private:
+	static constexpr int treeSize = 1 << levels;
+
+	struct Layout {
+		std::array<ValueType, treeSize> tree{};
+		std::array<int, treeSize> treeRank{};
+		std::array<int, treeSize> leafRank{};
+	};
+
+	static constexpr void fill(Layout& layout, const std::array<ValueType, size>& sorted, int node, int& ind) {
+		if (node < treeSize) {
+			fill(layout, sorted, 2 * node, ind);
+			layout.tree[node] = ind < size ? sorted[ind] : std::numeric_limits<ValueType>::max();
+			layout.treeRank[node] = ind < size ? ind : size;
+			++ind;
+			fill(layout, sorted, 2 * node + 1, ind);
+		}
+	}
+
+	static constexpr Layout buildLayout() {
+		Layout layout{};
+		int ind = 0;
+		fill(layout, ToArrayT<SortList<Thresholds>>::value, 1, ind);
+		layout.treeRank[0] = size;
+		// the leaf a search ends on determines the answer: drop the trailing right turns and the last left turn
+		for (int leaf = 0; leaf < treeSize; ++leaf) {
+			int node = treeSize + leaf;
+			while (node & 1) {
+				node >>= 1;
+			}
+			layout.leafRank[leaf] = layout.treeRank[node >> 1];
+		}
+		return layout;
+	}
+
+	static constexpr Layout layout = buildLayout();
+
+public:
+	static constexpr const std::array<ValueType, treeSize>& tree = layout.tree;
+
+	static constexpr int lowerBound(ValueType key) {
+		unsigned node = 1;
+		for (int level = 0; level < levels; ++level) {
+			node = 2 * node + (layout.tree[node] < key);
+		}
+		return layout.leafRank[node - treeSize];
+	}
+
+	// classifies keys in blocks, descending all keys of a block one level at a time
+	// so their loads overlap and the inner loop can be vectorised with gathers
+	static void lowerBound(const ValueType* keys, int* buckets, std::size_t count) {
+		constexpr std::size_t block = 32;
+		std::size_t i = 0;
+		for (; i + block <= count; i += block) {
+			unsigned nodes[block];
+			for (std::size_t j = 0; j < block; ++j) {
+				nodes[j] = 1;
+			}
+			for (int level = 0; level < levels; ++level) {
+				for (std::size_t j = 0; j < block; ++j) {
+					nodes[j] = 2 * nodes[j] + (layout.tree[nodes[j]] < keys[i + j]);
+				}
+			}
+			for (std::size_t j = 0; j < block; ++j) {
+				buckets[i + j] = layout.leafRank[nodes[j] - treeSize];
+			}
+		}
+		for (; i < count; ++i) {
+			buckets[i] = lowerBound(keys[i]);
+		}
+	}
+};
+
+using TestBucketing = Bucketing<ValueList<int, 50, 10, 1000, 100, 500>>;
+
+static_assert(TestBucketing::levels == 3, "");
+static_assert(TestBucketing::tree[1] == 500, "");
+static_assert(TestBucketing::lowerBound(-5) == 0, "");
+static_assert(TestBucketing::lowerBound(10) == 0, "");
+static_assert(TestBucketing::lowerBound(11) == 1, "");
+static_assert(TestBucketing::lowerBound(100) == 2, "");
+static_assert(TestBucketing::lowerBound(1000) == 4, "");
+static_assert(TestBucketing::lowerBound(1001) == 5, "");
+static_assert(TestBucketing::lowerBound(std::numeric_limits<int>::max()) == 5, "");
+static_assert(Bucketing<ValueList<int, 7>>::lowerBound(7) == 0, "");
+static_assert(Bucketing<ValueList<int, 7>>::lowerBound(8) == 1, "");
+static_assert(Bucketing<ValueList<int, 1, 2, 3, 4, 5, 6, 7>>::lowerBound(5) == 4, "");
@@ -1,3 +1,7 @@
+#pragma once
+
+#include "basics.hpp"
+
 #include <functional>
 
 namespace {
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "basics.hpp"
+#include "function.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// highestBit
+
+inline int highestBit(std::uint64_t v) {
+#if defined(_MSC_VER)
+	unsigned long ind;
+	_BitScanReverse64(&ind, v);
+	return static_cast<int>(ind);
+#else
+	return 63 - __builtin_clzll(v);
+#endif
+}
+
+// LatencyHistogram
+// log-linear buckets like HDR histograms: exact below subBuckets ns, then subBuckets buckets per power of two (<= 12.5% error)
+
+struct LatencyHistogram {
+	static constexpr int subBucketBits = 3;
+	static constexpr int subBuckets = 1 << subBucketBits;
+	static constexpr int numBuckets = (64 - subBucketBits + 1) * subBuckets;
+
+	static int bucket(std::uint64_t ns) {
+		if (ns < subBuckets) {
+			return static_cast<int>(ns);
+		}
+		const int shift = highestBit(ns) - subBucketBits;
+		return (shift + 1) * subBuckets + static_cast<int>((ns >> shift) & (subBuckets - 1));
+	}
+
+	static constexpr std::uint64_t bucketUpperBound(int ind) {
+		if (ind < subBuckets) {
+			return static_cast<std::uint64_t>(ind);
+		}
+		const int shift = ind / subBuckets - 1;
+		const std::uint64_t lower = static_cast<std::uint64_t>(subBuckets + ind % subBuckets) << shift;
+		return lower + ((std::uint64_t(1) << shift) - 1);
+	}
+
+	void record(std::uint64_t ns) {
+		counts[bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	std::array<std::atomic<std::uint64_t>, numBuckets> counts{};
+};
+
+// LatencyReport
+
+struct LatencyReport {
+	std::uint64_t calls = 0;
+	std::array<std::uint64_t, LatencyHistogram::numBuckets> counts{};
+
+	// upper bound in nanoseconds of the bucket holding the given percentile (0..100), by nearest rank
+	constexpr std::uint64_t percentile(double p) const {
+		if (calls == 0) {
+			return 0;
+		}
+		// std::ceil isn't constexpr
+		const double rank = p * static_cast<double>(calls) / 100.0;
+		std::uint64_t target = static_cast<std::uint64_t>(rank);
+		target += static_cast<double>(target) < rank ? 1 : 0;
+		target = target < 1 ? 1 : target < calls ? target : calls;
+		std::uint64_t seen = 0;
+		for (int i = 0; i < LatencyHistogram::numBuckets; ++i) {
+			seen += counts[i];
+			if (seen >= target) {
+				return LatencyHistogram::bucketUpperBound(i);
+			}
+		}
+		return 0;
+	}
+
+	constexpr std::uint64_t max() const {
+		return percentile(100.0);
+	}
+};
+
+namespace {
+	template<int... Buckets>
+	constexpr LatencyReport testReport() {
+		LatencyReport report;
+		((++report.counts[Buckets], ++report.calls), ...);
+		return report;
+	}
+}
+
+// below 16ns every nanosecond has its own bucket, 100ns falls into bucket 36 and 100us into bucket 116
+static_assert(testReport<1, 2, 3, 4, 5, 6, 7, 8, 9, 10>().percentile(95.0) == 10, "");
+static_assert(testReport<1, 2, 3, 4, 5, 6, 7, 8, 9, 10>().percentile(50.0) == 5, "");
+static_assert(testReport<1, 2, 3, 4, 5, 6, 7, 8, 9, 10>().percentile(0.0) == 1, "");
+static_assert(testReport<36, 116>().percentile(50.0) == 103, "");
+static_assert(testReport<36, 116>().percentile(99.0) == 106495, "");
+static_assert(testReport<36, 116>().max() == 106495, "");
+
+// LatencyStats
+// every thread records into the histogram slot of its thread number modulo maxThreads. Thread numbers are
+// handed out process wide on first use and never reused, so once more than maxThreads threads have recorded
+// into any LatencyStats, exited ones included, new threads share slots (and contend on their counters)
+
+inline int threadSlot() {
+	static std::atomic<int> nextSlot{ 0 };
+	thread_local const int slot = nextSlot.fetch_add(1, std::memory_order_relaxed);
+	return slot;
+}
+
+class LatencyStats {
+public:
+	static constexpr int maxThreads = 64;
+
+	LatencyStats() = default;
+	LatencyStats(const LatencyStats&) = delete;
+	LatencyStats& operator=(const LatencyStats&) = delete;
+
+	~LatencyStats() {
+		for (auto& slot : slots) {
+			delete slot.load(std::memory_order_relaxed);
+		}
+	}
+
+	void record(std::uint64_t ns) {
+		auto& slot = slots[threadSlot() % maxThreads];
+		LatencyHistogram* histogram = slot.load(std::memory_order_acquire);
+		if (!histogram) {
+			histogram = allocate(slot);
+		}
+		histogram->record(ns);
+	}
+
+	LatencyReport snapshot() const {
+		LatencyReport report;
+		for (auto& slot : slots) {
+			if (const LatencyHistogram* histogram = slot.load(std::memory_order_acquire)) {
+				for (int i = 0; i < LatencyHistogram::numBuckets; ++i) {
+					const std::uint64_t count = histogram->counts[i].load(std::memory_order_relaxed);
+					report.counts[i] += count;
+					report.calls += count;
+				}
+			}
+		}
+		return report;
+	}
+
+private:
+	static LatencyHistogram* allocate(std::atomic<LatencyHistogram*>& slot) {
+		auto* histogram = new LatencyHistogram();
+		LatencyHistogram* expected = nullptr;
+		if (!slot.compare_exchange_strong(expected, histogram, std::memory_order_acq_rel)) {
+			delete histogram;
+			return expected;
+		}
+		return histogram;
+	}
+
+	std::array<std::atomic<LatencyHistogram*>, maxThreads> slots{};
+};
+
+// Instrumented
+// wraps a callable keeping its exact signature and records count and steady_clock latency of every call,
+// copies share their stats. Measured overhead is about 85ns per call with GCC 12 -O2 on an x86-64 Linux VM,
+// where a single steady_clock::now() costs about 41ns (bench/instrumented.cpp), plus 4KB of histogram per recording thread
+
+template<class Derived, class Ret, class Params>
+class InstrumentedCall;
+
+template<class Derived, class Ret, template<class...> class List, class... Params>
+class InstrumentedCall<Derived, Ret, List<Params...>> {
+public:
+	Ret operator()(Params... params) const {
+		const Derived& self = static_cast<const Derived&>(*this);
+		const auto start = std::chrono::steady_clock::now();
+		struct Record {
+			const Derived& self;
+			std::chrono::steady_clock::time_point start;
+
+			~Record() {
+				const auto end = std::chrono::steady_clock::now();
+				self.stats->record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+			}
+		} record{ self, start };
+		return self.func(std::forward<Params>(params)...);
+	}
+};
+
+template<class F>
+class Instrumented : public InstrumentedCall<Instrumented<F>, typename Function<F>::Ret, typename Function<F>::Params> {
+public:
+	static_assert(!Function<F>::isMemberFunction, "Instrumented can't call member function pointers, wrap them in a lambda");
+
+	using Signature = typename Function<F>::Signature;
+
+	explicit Instrumented(F func)
+		: func(std::move(func))
+		, stats(std::make_shared<LatencyStats>())
+	{}
+
+	LatencyReport snapshot() const {
+		return stats->snapshot();
+	}
+
+private:
+	friend class InstrumentedCall<Instrumented<F>, typename Function<F>::Ret, typename Function<F>::Params>;
+
+	mutable F func;
+	std::shared_ptr<LatencyStats> stats;
+};
+
+static_assert(std::is_same_v<Function<Instrumented<decltype(testLambda)>>::Signature, bool(int, float)>, "");
+static_assert(std::is_same_v<Function<Instrumented<TestCallable>>::Signature, void(char, double)>, "");
+static_assert(std::is_same_v<Function<Instrumented<decltype(&testGlobalFunction)>>::Signature, int(char)>, "");
+static_assert(IsCallable<Instrumented<decltype(testLambda)>>, "");
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "algorithms.hpp"
+
+#include <cstddef>
+#include <utility>
+
+// Coefficients are integral Values (floating point non-type template parameters need C++20),
+// a Scale divides the result so fixed point coefficients like 1/4, 2/4, 1/4 can be expressed.
+
+// Tap
+
+template<int Ind, class Coeff>
+struct Tap {};
+
+// Taps
+
+template<class, class>
+struct TapsT;
+
+template<template<class...> class List, class... Coeffs, int... Inds>
+struct TapsT<List<Coeffs...>, std::integer_sequence<int, Inds...>> {
+	using Type = TypeList<Tap<Inds, Coeffs>...>;
+};
+
+template<class Coeffs>
+using Taps = typename TapsT<Coeffs, std::make_integer_sequence<int, ListSize<Coeffs>::value>>::Type;
+
+static_assert(std::is_same_v<Taps<ValueList<int>>, TypeList<>>, "");
+static_assert(std::is_same_v<Taps<ValueList<int, 3, 0>>, TypeList<Tap<0, Value<int, 3>>, Tap<1, Value<int, 0>>>>, "");
+
+// IsZeroTap
+
+struct IsZeroTap {
+	template<int Ind, class T, T Coeff>
+	static constexpr bool apply(Tap<Ind, Value<T, Coeff>>) {
+		return Coeff == 0;
+	}
+};
+
+// NonZeroTaps
+
+template<class Coeffs>
+using NonZeroTaps = RemoveIf<Taps<Coeffs>, IsZeroTap>;
+
+static_assert(std::is_same_v<NonZeroTaps<ValueList<int, 0, 2, 0, 1>>, TypeList<Tap<1, Value<int, 2>>, Tap<3, Value<int, 1>>>>, "");
+static_assert(std::is_same_v<NonZeroTaps<ValueList<int, 0, 0>>, TypeList<>>, "");
+
+// scaleBy
+
+template<int Scale, class T>
+constexpr T scaleBy(T v) {
+	if constexpr (Scale == 1) {
+		return v;
+	} else if constexpr (std::is_integral_v<T>) {
+		return v / T(Scale);
+	} else {
+		return v * (T(1) / T(Scale));
+	}
+}
+
+static_assert(scaleBy<4>(6.0) == 1.5, "");
+static_assert(scaleBy<4>(16) == 4, "");
+
+// mulCoeff
+// coefficients 1 and -1 are folded away
+
+template<class C, C Coeff, class T>
+constexpr T mulCoeff(T v) {
+	if constexpr (Coeff == 1) {
+		return v;
+	} else if constexpr (Coeff == -1) {
+		return -v;
+	} else {
+		return T(Coeff) * v;
+	}
+}
+
+static_assert(mulCoeff<int, 1>(3.0) == 3.0, "");
+static_assert(mulCoeff<int, -1>(3.0) == -3.0, "");
+static_assert(mulCoeff<int, 2>(3.0) == 6.0, "");
+
+// DotProduct
+
+template<class>
+struct DotProductT;
+
+template<>
+struct DotProductT<TypeList<>> {
+	template<class T>
+	static constexpr T apply(const T*) {
+		return T(0);
+	}
+};
+
+template<int... Inds, class C, C... Coeffs>
+struct DotProductT<TypeList<Tap<Inds, Value<C, Coeffs>>...>> {
+	template<class T>
+	static constexpr T apply(const T* x) {
+		return (mulCoeff<C, Coeffs>(x[Inds]) + ...);
+	}
+};
+
+template<class Coeffs, int Scale = 1, class T>
+constexpr T dotProduct(const T* x) {
+	return scaleBy<Scale>(DotProductT<NonZeroTaps<Coeffs>>::apply(x));
+}
+
+namespace {
+	constexpr double testSignal[] = { 1.0, 2.0, 3.0, 4.0, 5.0 };
+	constexpr int testIntSignal[] = { 4, 8, 4 };
+}
+
+static_assert(dotProduct<ValueList<int, 1, 0, -2>>(testSignal) == -5.0, "");
+static_assert(dotProduct<ValueList<int, 0, 0>>(testSignal) == 0.0, "");
+static_assert(dotProduct<ValueList<int, 1, 2, 1>, 4>(testSignal) == 2.0, "");
+static_assert(dotProduct<ValueList<int, 1, 2, 1>, 4>(testIntSignal) == 6, "");
+
+// fir
+// out[i] is the dot product of Coeffs with in[i..i + ListSize<Coeffs>), in holds size + ListSize<Coeffs> - 1 samples
+
+template<class Coeffs, int Scale = 1, class T>
+constexpr void fir(const T* in, T* out, std::size_t size) {
+	for (std::size_t i = 0; i < size; ++i) {
+		out[i] = dotProduct<Coeffs, Scale>(in + i);
+	}
+}
+
+// Polynomial
+// Coeffs are ordered from the constant term up, evaluated with Horner's scheme
+
+template<class C, C Coeff, class T>
+constexpr T addCoeff(T v) {
+	if constexpr (Coeff == 0) {
+		return v;
+	} else {
+		return v + T(Coeff);
+	}
+}
+
+template<class>
+struct PolynomialT;
+
+template<>
+struct PolynomialT<TypeList<>> {
+	template<class T>
+	static constexpr T apply(T) {
+		return T(0);
+	}
+};
+
+template<class C, C Head, C... Tail>
+struct PolynomialT<TypeList<Value<C, Head>, Value<C, Tail>...>> {
+	template<class T>
+	static constexpr T apply([[maybe_unused]] T x) {
+		T res = T(Head);
+		((res = addCoeff<C, Tail>(res * x)), ...);
+		return res;
+	}
+};
+
+template<class Coeffs, int Scale = 1, class T>
+constexpr T polynomial(T x) {
+	return scaleBy<Scale>(PolynomialT<Reverse<ToTypeList<Coeffs>>>::apply(x));
+}
+
+template<class Coeffs, int Scale = 1, class T>
+constexpr void polynomial(const T* in, T* out, std::size_t size) {
+	for (std::size_t i = 0; i < size; ++i) {
+		out[i] = polynomial<Coeffs, Scale>(in[i]);
+	}
+}
+
+static_assert(polynomial<ValueList<int>>(2.0) == 0.0, "");
+static_assert(polynomial<ValueList<int, 5>>(2.0) == 5.0, "");
+static_assert(polynomial<ValueList<int, 1, 0, 3>>(2.0) == 13.0, "");
+static_assert(polynomial<ValueList<int, 0, -1, 0, 1>>(2.f) == 6.f, "");
+static_assert(polynomial<ValueList<int, 2, 4>, 2>(2.0) == 5.0, "");
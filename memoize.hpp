@@ -0,0 +1,266 @@
+#pragma once
+
+#include "basics.hpp"
+#include "function.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// MemoKey
+
+template<class>
+struct MemoKeyT;
+
+template<template<class...> class List, class... Params>
+struct MemoKeyT<List<Params...>> {
+	static_assert(((!std::is_lvalue_reference_v<Params> || std::is_const_v<std::remove_reference_t<Params>>) && ...),
+		"memoized functions can't take non-const references");
+
+	using Type = std::tuple<std::decay_t<Params>...>;
+};
+
+template<class F>
+using MemoKey = typename MemoKeyT<typename Function<F>::Params>::Type;
+
+static_assert(std::is_same_v<MemoKey<decltype(testLambda)>, std::tuple<int, float>>, "");
+static_assert(std::is_same_v<MemoKey<void(const std::string&, const int)>, std::tuple<std::string, int>>, "");
+
+// TupleHash
+
+struct TupleHash {
+	template<class... Ts>
+	std::size_t operator()(const std::tuple<Ts...>& tuple) const {
+		return std::apply([](const Ts&... vals) {
+			std::size_t seed = 0;
+			((seed ^= std::hash<Ts>{}(vals) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2)), ...);
+			return seed;
+		}, tuple);
+	}
+};
+
+// mixHash
+// splitmix64's finalizer, spreads hashes that only differ in a few bits (like std::hash of small integers,
+// which is the identity in libstdc++) over all bits
+
+constexpr std::uint64_t mixHash(std::uint64_t hash) {
+	hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+	hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+	return hash ^ (hash >> 31);
+}
+
+namespace {
+	// whether each of 16 shards gets between half and twice its share of the hashes base .. base + 255
+	constexpr bool testShardsBalanced(std::uint64_t base) {
+		int counts[16]{};
+		for (std::uint64_t i = 0; i < 256; ++i) {
+			++counts[mixHash(base + i) % 16];
+		}
+		for (int count : counts) {
+			if (count < 8 || count > 32) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+// TupleHash of std::tuple<int>(i) is i + 0x9e3779b97f4a7c15 with libstdc++
+static_assert(testShardsBalanced(0), "");
+static_assert(testShardsBalanced(0x9e3779b97f4a7c15ull), "");
+
+// LruCache
+
+template<class Key, class Value, class Hash = TupleHash>
+class LruCache {
+public:
+	explicit LruCache(std::size_t capacity)
+		: capacity(capacity < 1 ? 1 : capacity)
+	{}
+
+	std::optional<Value> find(const Key& key) {
+		auto it = index.find(key);
+		if (it == index.end()) {
+			return std::nullopt;
+		}
+		entries.splice(entries.begin(), entries, it->second);
+		return it->second->second;
+	}
+
+	void insert(const Key& key, const Value& value) {
+		auto it = index.find(key);
+		if (it != index.end()) {
+			it->second->second = value;
+			entries.splice(entries.begin(), entries, it->second);
+			return;
+		}
+		if (index.size() == capacity) {
+			index.erase(entries.back().first);
+			entries.pop_back();
+		}
+		entries.emplace_front(key, value);
+		index.emplace(key, entries.begin());
+	}
+
+private:
+	using Entries = std::list<std::pair<Key, Value>>;
+
+	std::size_t capacity;
+	Entries entries;
+	std::unordered_map<Key, typename Entries::iterator, Hash> index;
+};
+
+// ShardedLruCache
+// keys are spread over independently locked LRU shards, so concurrent callers rarely wait on each other
+
+template<class Key, class Value, class Hash = TupleHash>
+class ShardedLruCache {
+public:
+	ShardedLruCache(std::size_t capacity, std::size_t numShards) {
+		numShards = numShards < 1 ? 1 : numShards;
+		shards.reserve(numShards);
+		for (std::size_t i = 0; i < numShards; ++i) {
+			shards.push_back(std::make_unique<Shard>((capacity + numShards - 1) / numShards));
+		}
+	}
+
+	std::optional<Value> find(const Key& key) {
+		Shard& shard = shardFor(key);
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		return shard.cache.find(key);
+	}
+
+	void insert(const Key& key, const Value& value) {
+		Shard& shard = shardFor(key);
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		shard.cache.insert(key, value);
+	}
+
+private:
+	struct Shard {
+		explicit Shard(std::size_t capacity)
+			: cache(capacity)
+		{}
+
+		std::mutex mutex;
+		LruCache<Key, Value, Hash> cache;
+	};
+
+	Shard& shardFor(const Key& key) {
+		// the shard's map picks buckets from the unmixed hash, so keys of one shard still spread over its buckets
+		return *shards[static_cast<std::size_t>(mixHash(Hash{}(key)) % shards.size())];
+	}
+
+	std::vector<std::unique_ptr<Shard>> shards;
+};
+
+// MemoizeCall
+
+template<class Derived, class Ret, class Params>
+class MemoizeCall;
+
+template<class Derived, class Ret, template<class...> class List, class... Params>
+class MemoizeCall<Derived, Ret, List<Params...>> {
+public:
+	static_assert(!std::is_void_v<Ret>, "memoized functions must return a value");
+
+	std::decay_t<Ret> operator()(Params... params) const {
+		return static_cast<const Derived&>(*this).lookup(std::forward<Params>(params)...);
+	}
+};
+
+// Memoize
+// caches results in a bounded, sharded LRU cache keyed on the decayed parameters, copies share the cache.
+// The function runs outside the shard lock, so concurrent misses on one key may each call it
+
+template<class F>
+class Memoize : public MemoizeCall<Memoize<F>, typename Function<F>::Ret, typename Function<F>::Params> {
+public:
+	static_assert(!Function<F>::isMemberFunction, "Memoize can't call member function pointers, wrap them in a lambda");
+
+	using Signature = typename Function<F>::Signature;
+
+	explicit Memoize(F func, std::size_t capacity = 1024, std::size_t numShards = 16)
+		: func(std::move(func))
+		, cache(std::make_shared<Cache>(capacity, numShards))
+	{}
+
+private:
+	using Ret = std::decay_t<typename Function<F>::Ret>;
+	using Cache = ShardedLruCache<MemoKey<F>, Ret>;
+
+	friend class MemoizeCall<Memoize<F>, typename Function<F>::Ret, typename Function<F>::Params>;
+
+	template<class... Params>
+	Ret lookup(Params&&... params) const {
+		MemoKey<F> key(params...);
+		if (std::optional<Ret> cached = cache->find(key)) {
+			return *std::move(cached);
+		}
+		Ret res = func(std::forward<Params>(params)...);
+		cache->insert(key, res);
+		return res;
+	}
+
+	mutable F func;
+	std::shared_ptr<Cache> cache;
+};
+
+// MemoizePure
+// for pure functions of one integral parameter: every argument in [Min, Max] gets its own slot in a
+// direct-mapped table that is filled once and never evicted, arguments outside the range aren't cached
+
+template<class F, long long Min, long long Max>
+class MemoizePure : public MemoizeCall<MemoizePure<F, Min, Max>, typename Function<F>::Ret, typename Function<F>::Params> {
+public:
+	static_assert(!Function<F>::isMemberFunction, "MemoizePure can't call member function pointers, wrap them in a lambda");
+	static_assert(Function<F>::numParams == 1 && std::is_integral_v<std::decay_t<typename Function<F>::template Param<0>::Type>>,
+		"MemoizePure needs a function of one integral parameter");
+	static_assert(Min <= Max, "");
+
+	using Signature = typename Function<F>::Signature;
+
+	explicit MemoizePure(F func)
+		: func(std::move(func))
+		, table(std::make_shared<Table>())
+	{}
+
+private:
+	using Ret = std::decay_t<typename Function<F>::Ret>;
+
+	struct Slot {
+		std::once_flag once;
+		std::optional<Ret> value;
+	};
+
+	using Table = std::array<Slot, static_cast<std::size_t>(Max - Min + 1)>;
+
+	friend class MemoizeCall<MemoizePure<F, Min, Max>, typename Function<F>::Ret, typename Function<F>::Params>;
+
+	template<class Param>
+	Ret lookup(Param param) const {
+		const long long arg = static_cast<long long>(param);
+		if (arg < Min || arg > Max) {
+			return func(param);
+		}
+		Slot& slot = (*table)[static_cast<std::size_t>(arg - Min)];
+		std::call_once(slot.once, [this, &slot, param]() { slot.value.emplace(func(param)); });
+		return *slot.value;
+	}
+
+	mutable F func;
+	std::shared_ptr<Table> table;
+};
+
+static_assert(std::is_same_v<Function<Memoize<decltype(testLambda)>>::Signature, bool(int, float)>, "");
+static_assert(std::is_same_v<Function<MemoizePure<decltype(&testGlobalFunction), 0, 127>>::Signature, int(char)>, "");
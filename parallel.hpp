@@ -0,0 +1,347 @@
+#pragma once
+
+#include "algorithms.hpp"
+#include "function.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace {
+	auto testConfigStage = []() { return 1; };
+	auto testLoggerStage = [](int) { return 2.f; };
+	auto testNetworkStage = [](const int&, float) { return true; };
+	auto testAudioStage = []() {};
+}
+
+// StageResult
+
+template<class Stage>
+struct StageResultT {
+	using Type = std::decay_t<typename Function<Stage>::Ret>;
+};
+
+template<class Stage>
+using StageResult = typename StageResultT<Stage>::Type;
+
+static_assert(std::is_same_v<StageResult<decltype(testConfigStage)>, int>, "");
+static_assert(std::is_same_v<StageResult<decltype(testAudioStage)>, void>, "");
+
+// StageDependencies
+// a parameter of stage Ind is fed by the first earlier stage returning its decayed type
+
+template<class Stages, int Ind, class Params = typename Function<NthElement<Stages, Ind>>::Params>
+struct StageDependenciesT;
+
+template<class Stages, int Ind, template<class...> class List, class... Params>
+struct StageDependenciesT<Stages, Ind, List<Params...>> {
+private:
+	using Produced = Transform<ListHead<Ind, ToTypeList<Stages>>, StageResultT>;
+
+public:
+	using Type = ValueList<int, IndexOf<std::decay_t<Params>, Produced>::value...>;
+
+	static_assert(IsEmpty<Filter<Type, LessEq<Value<int, -1>>>>::value, "every stage parameter must be returned by an earlier stage");
+};
+
+template<class Stages, int Ind>
+using StageDependencies = typename StageDependenciesT<Stages, Ind>::Type;
+
+using TestStages = TypeList<decltype(testConfigStage), decltype(testAudioStage), decltype(testLoggerStage), decltype(testNetworkStage)>;
+
+static_assert(std::is_same_v<StageDependencies<TestStages, 0>, ValueList<int>>, "");
+static_assert(std::is_same_v<StageDependencies<TestStages, 1>, ValueList<int>>, "");
+static_assert(std::is_same_v<StageDependencies<TestStages, 2>, ValueList<int, 0>>, "");
+static_assert(std::is_same_v<StageDependencies<TestStages, 3>, ValueList<int, 0, 2>>, "");
+static_assert(std::is_same_v<StageDependencies<std::tuple<decltype(testConfigStage), decltype(testLoggerStage)>, 1>, ValueList<int, 0>>, "");
+
+// StageOutput
+// what parallelApply reports for a stage, std::monostate for void stages
+
+template<class Stage>
+using StageOutput = std::conditional_t<std::is_void_v<StageResult<Stage>>, std::monostate, StageResult<Stage>>;
+
+static_assert(std::is_same_v<StageOutput<decltype(testAudioStage)>, std::monostate>, "");
+static_assert(std::is_same_v<StageOutput<decltype(testLoggerStage)>, float>, "");
+
+// ThreadPool
+// fixed number of workers, each with its own deque: a worker runs its newest task first and steals the oldest
+// task of another worker when its own deque is empty. Threads waiting in runUntil run queued tasks meanwhile,
+// so waiting on a pool from inside one of its tasks can't starve it
+
+class ThreadPool {
+public:
+	using Task = std::function<void()>;
+
+	explicit ThreadPool(unsigned numThreads = std::max(std::thread::hardware_concurrency(), 1u)) {
+		numThreads = numThreads < 1 ? 1 : numThreads;
+		for (unsigned i = 0; i < numThreads; ++i) {
+			queues.push_back(std::make_unique<Queue>());
+		}
+		for (unsigned i = 0; i < numThreads; ++i) {
+			threads.emplace_back([this, i]() { work(i); });
+		}
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// runs the remaining tasks before joining the workers
+	~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stop = true;
+		}
+		wake.notify_all();
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+
+	unsigned size() const {
+		return static_cast<unsigned>(queues.size());
+	}
+
+	void submit(Task task) {
+		const unsigned ind = currentPool == this ? currentInd : nextQueue.fetch_add(1, std::memory_order_relaxed) % size();
+		{
+			std::lock_guard<std::mutex> lock(queues[ind]->mutex);
+			queues[ind]->tasks.push_back(std::move(task));
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			++pending;
+		}
+		wake.notify_one();
+	}
+
+	// runs queued tasks on the calling thread until done() holds, done must become true through notify()
+	template<class Done>
+	void runUntil(Done done) {
+		const unsigned self = currentPool == this ? currentInd : 0;
+		while (!done()) {
+			if (tryRun(self)) {
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this, &done]() { return pending > 0 || done(); });
+		}
+	}
+
+	void notify() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+		}
+		wake.notify_all();
+	}
+
+private:
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	bool tryRun(unsigned self) {
+		Task task;
+		for (unsigned i = 0; i < size() && !task; ++i) {
+			Queue& queue = *queues[(self + i) % size()];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.tasks.empty()) {
+				if (i == 0) {
+					task = std::move(queue.tasks.back());
+					queue.tasks.pop_back();
+				} else {
+					task = std::move(queue.tasks.front());
+					queue.tasks.pop_front();
+				}
+			}
+		}
+		if (!task) {
+			return false;
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			--pending;
+		}
+		task();
+		return true;
+	}
+
+	void work(unsigned ind) {
+		currentPool = this;
+		currentInd = ind;
+		while (true) {
+			if (tryRun(ind)) {
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this]() { return stop || pending > 0; });
+			if (stop && pending == 0) {
+				return;
+			}
+		}
+	}
+
+	static inline thread_local const ThreadPool* currentPool = nullptr;
+	static inline thread_local unsigned currentInd = 0;
+
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::thread> threads;
+	std::atomic<unsigned> nextQueue{ 0 };
+	std::mutex mutex;
+	std::condition_variable wake;
+	long pending = 0;
+	bool stop = false;
+};
+
+inline ThreadPool& defaultThreadPool() {
+	static ThreadPool pool;
+	return pool;
+}
+
+// StageGraph
+// every stage counts the results it still waits for and is submitted by the stage that brings the count to 0,
+// so no thread blocks on a dependency. Stages depending on a stage that threw are skipped
+
+template<class... Stages>
+class StageGraph : public std::enable_shared_from_this<StageGraph<Stages...>> {
+public:
+	using Results = std::tuple<StageOutput<Stages>...>;
+
+	static Results run(std::tuple<Stages...> stages, ThreadPool& pool) {
+		auto graph = std::make_shared<StageGraph>(std::move(stages), pool);
+		graph->start(Inds{});
+		pool.runUntil([&graph]() { return graph->unfinished.load(std::memory_order_acquire) == 0; });
+		if (graph->error) {
+			std::rethrow_exception(graph->error);
+		}
+		return std::apply([](auto&... result) { return Results(*std::move(result)...); }, graph->results);
+	}
+
+	StageGraph(std::tuple<Stages...> stages, ThreadPool& pool)
+		: stages(std::move(stages))
+		, pool(pool)
+	{}
+
+private:
+	static constexpr int numStages = sizeof...(Stages);
+
+	using Inds = std::make_integer_sequence<int, numStages>;
+	using StageList = TypeList<Stages...>;
+
+	template<int J, int... Deps>
+	static constexpr int countDependencies(TypeList<Value<int, Deps>...>) {
+		return ((Deps == J ? 1 : 0) + ... + 0);
+	}
+
+	template<int... Is>
+	void start(std::integer_sequence<int, Is...>) {
+		((waiting[Is] = ListSize<StageDependencies<StageList, Is>>::value), ...);
+		((ListSize<StageDependencies<StageList, Is>>::value == 0 ? submit<Is>() : void()), ...);
+	}
+
+	template<int I>
+	void submit() {
+		pool.submit([self = this->shared_from_this()]() { self->template runStage<I>(StageDependencies<StageList, I>{}); });
+	}
+
+	template<int I>
+	void release(int count) {
+		if (waiting[I].fetch_sub(count, std::memory_order_acq_rel) == count) {
+			submit<I>();
+		}
+	}
+
+	template<int I, int... Deps>
+	void runStage(TypeList<Value<int, Deps>...>) {
+		if ((failed[Deps] || ...)) {
+			failed[I] = true;
+		} else {
+			try {
+				auto& stage = std::get<I>(stages);
+				if constexpr (std::is_void_v<StageResult<NthElement<StageList, I>>>) {
+					stage(std::as_const(*std::get<Deps>(results))...);
+					std::get<I>(results).emplace();
+				} else {
+					std::get<I>(results).emplace(stage(std::as_const(*std::get<Deps>(results))...));
+				}
+			} catch (...) {
+				failed[I] = true;
+				std::lock_guard<std::mutex> lock(errorMutex);
+				if (!error) {
+					error = std::current_exception();
+				}
+			}
+		}
+		finishStage<I>(Inds{});
+	}
+
+	template<int J, int... Is>
+	void finishStage(std::integer_sequence<int, Is...>) {
+		((countDependencies<J>(StageDependencies<StageList, Is>{}) > 0 ? release<Is>(countDependencies<J>(StageDependencies<StageList, Is>{})) : void()), ...);
+		if (unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			pool.notify();
+		}
+	}
+
+	std::tuple<Stages...> stages;
+	ThreadPool& pool;
+	std::tuple<std::optional<StageOutput<Stages>>...> results;
+	std::array<std::atomic<int>, numStages> waiting{};
+	std::array<bool, numStages> failed{};
+	std::atomic<int> unfinished{ numStages };
+	std::mutex errorMutex;
+	std::exception_ptr error;
+};
+
+// parallelApply
+// runs the stages on a ThreadPool, each as soon as the stages it depends on have finished, and returns
+// all their results. The first exception thrown by a stage is rethrown once the other stages are done
+
+template<class... Stages>
+auto parallelApply(std::tuple<Stages...> stages, ThreadPool& pool = defaultThreadPool()) {
+	return StageGraph<Stages...>::run(std::move(stages), pool);
+}
+
+// parallelForEach
+// calls func on every tuple element concurrently, the first exception is rethrown once all calls are done
+
+template<class Tuple, class Func>
+void parallelForEach(Tuple& tuple, Func func, ThreadPool& pool = defaultThreadPool()) {
+	struct State {
+		std::atomic<int> unfinished{ static_cast<int>(std::tuple_size_v<Tuple>) };
+		std::mutex errorMutex;
+		std::exception_ptr error;
+	};
+	auto state = std::make_shared<State>();
+	std::apply([&](auto&... el) {
+		(pool.submit([state, &pool, &func, &el]() {
+			try {
+				func(el);
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(state->errorMutex);
+				if (!state->error) {
+					state->error = std::current_exception();
+				}
+			}
+			if (state->unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				pool.notify();
+			}
+		}), ...);
+	}, tuple);
+	pool.runUntil([&state]() { return state->unfinished.load(std::memory_order_acquire) == 0; });
+	if (state->error) {
+		std::rethrow_exception(state->error);
+	}
+}
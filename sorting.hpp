@@ -0,0 +1,265 @@
+#pragma once
+
+#include "basics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define SORTING_NETWORK_SIMD_FLOAT
+#if defined(__SSE4_1__) || defined(__AVX__)
+#define SORTING_NETWORK_SIMD_INT32
+#endif
+#endif
+
+// SORTING_NETWORK_INLINE keeps the expansion over comparator indices out of symbols, with GCC and Clang even at -O0.
+// SORTING_NETWORK_INLINE_OPTIMISED forces compare-exchanges inline only when optimising, where large networks would
+// otherwise exhaust the inliner's budget, so unoptimised builds keep a single copy of each compare-exchange
+#if defined(_MSC_VER)
+#define SORTING_NETWORK_INLINE __forceinline
+#define SORTING_NETWORK_INLINE_OPTIMISED __forceinline
+#else
+#define SORTING_NETWORK_INLINE inline __attribute__((always_inline))
+#if defined(__OPTIMIZE__)
+#define SORTING_NETWORK_INLINE_OPTIMISED inline __attribute__((always_inline))
+#else
+#define SORTING_NETWORK_INLINE_OPTIMISED inline
+#endif
+#endif
+
+// Comparator
+
+template<int I, int J>
+struct Comparator {};
+
+// OddEvenMergeNetwork
+// Batcher's odd-even merge sort generalised to any size, optimal up to 8 elements
+
+struct OddEvenMergeNetwork {
+	struct Pair {
+		int i;
+		int j;
+	};
+
+	template<class Func>
+	static constexpr void forEachComparator(int size, Func func) {
+		for (int p = 1; p < size; p *= 2) {
+			for (int k = p; k >= 1; k /= 2) {
+				for (int j = k % p; j <= size - 1 - k; j += 2 * k) {
+					for (int i = 0; i <= std::min(k - 1, size - j - k - 1); ++i) {
+						if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+							func(i + j, i + j + k);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	static constexpr int numComparators(int size) {
+		int count = 0;
+		forEachComparator(size, [&count](int, int) { ++count; });
+		return count;
+	}
+
+	template<int Size>
+	static constexpr auto comparators() {
+		std::array<Pair, OddEvenMergeNetwork::numComparators(Size)> res{};
+		int count = 0;
+		forEachComparator(Size, [&res, &count](int i, int j) {
+			res[count].i = i;
+			res[count].j = j;
+			++count;
+		});
+		return res;
+	}
+};
+
+static_assert(OddEvenMergeNetwork::numComparators(1) == 0, "");
+static_assert(OddEvenMergeNetwork::numComparators(2) == 1, "");
+static_assert(OddEvenMergeNetwork::numComparators(4) == 5, "");
+static_assert(OddEvenMergeNetwork::numComparators(8) == 19, "");
+static_assert(OddEvenMergeNetwork::numComparators(16) == 63, "");
+
+// SortingNetwork
+
+template<int Size>
+struct SortingNetworkT {
+	static constexpr auto comparators = OddEvenMergeNetwork::comparators<Size>();
+
+private:
+	template<std::size_t... Inds>
+	static auto toList(std::index_sequence<Inds...>) -> TypeList<Comparator<comparators[Inds].i, comparators[Inds].j>...>;
+
+public:
+	using Type = decltype(toList(std::make_index_sequence<comparators.size()>{}));
+};
+
+template<int Size>
+using SortingNetwork = typename SortingNetworkT<Size>::Type;
+
+static_assert(std::is_same_v<SortingNetwork<1>, TypeList<>>, "");
+static_assert(std::is_same_v<SortingNetwork<2>, TypeList<Comparator<0, 1>>>, "");
+static_assert(std::is_same_v<SortingNetwork<3>, TypeList<Comparator<0, 1>, Comparator<0, 2>, Comparator<1, 2>>>, "");
+static_assert(std::is_same_v<SortingNetwork<4>,
+	TypeList<Comparator<0, 1>, Comparator<2, 3>, Comparator<0, 2>, Comparator<1, 3>, Comparator<1, 2>>>, "");
+
+// ScalarCompareExchange
+
+struct ScalarCompareExchange {
+	template<class T>
+	SORTING_NETWORK_INLINE_OPTIMISED static constexpr void apply(T& a, T& b) {
+		// same results as std::min and std::max, but comparing values instead of returning references lets
+		// integers lower to cmov or pminsd/pmaxsd and floating point to minss/maxss
+		const T lo = b < a ? b : a;
+		const T hi = a < b ? b : a;
+		a = lo;
+		b = hi;
+	}
+};
+
+// applyNetwork
+// keyed on the network's identity type rather than its comparator list so that symbols don't spell out
+// every comparator, comparators are read from Network::comparators. The expansion over comparator indices
+// is always inlined, so only applyNetwork<CompareExchange, Network, T> is emitted
+
+template<class Network, int Ind>
+struct ComparatorAt {
+	static constexpr int i = Network::comparators[Ind].i;
+	static constexpr int j = Network::comparators[Ind].j;
+};
+
+template<class CompareExchange, class Network, class T, int... Inds>
+SORTING_NETWORK_INLINE constexpr void applyNetwork(T* vals, std::integer_sequence<int, Inds...>) {
+	(CompareExchange::apply(vals[ComparatorAt<Network, Inds>::i], vals[ComparatorAt<Network, Inds>::j]), ...);
+}
+
+template<class CompareExchange, class Network, class T>
+constexpr void applyNetwork(T* vals) {
+	applyNetwork<CompareExchange, Network>(vals, std::make_integer_sequence<int, static_cast<int>(Network::comparators.size())>{});
+}
+
+// sortNetwork
+
+template<class T, std::size_t N>
+constexpr void sortNetwork(std::array<T, N>& arr) {
+	applyNetwork<ScalarCompareExchange, SortingNetworkT<N>>(arr.data());
+}
+
+template<std::size_t N>
+constexpr bool sortsAllZeroOneInputs() {
+	for (unsigned mask = 0; mask < (1u << N); ++mask) {
+		std::array<int, N> arr{};
+		for (std::size_t i = 0; i < N; ++i) {
+			arr[i] = (mask >> i) & 1;
+		}
+		sortNetwork(arr);
+		for (std::size_t i = 1; i < N; ++i) {
+			if (arr[i - 1] > arr[i]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static_assert(sortsAllZeroOneInputs<3>(), "");
+static_assert(sortsAllZeroOneInputs<4>(), "");
+static_assert(sortsAllZeroOneInputs<7>(), "");
+static_assert(sortsAllZeroOneInputs<8>(), "");
+static_assert(sortsAllZeroOneInputs<11>(), "");
+
+// SimdCompareExchange
+
+#ifdef SORTING_NETWORK_SIMD_FLOAT
+struct SimdFloat {
+	using Type = float;
+	using Reg = __m128;
+	static constexpr int lanes = 4;
+
+	static Reg set(float v0, float v1, float v2, float v3) { return _mm_setr_ps(v0, v1, v2, v3); }
+	static void store(float* dst, Reg reg) { _mm_storeu_ps(dst, reg); }
+	static Reg min(Reg a, Reg b) { return _mm_min_ps(a, b); }
+	static Reg max(Reg a, Reg b) { return _mm_max_ps(a, b); }
+};
+#endif
+
+#ifdef SORTING_NETWORK_SIMD_INT32
+struct SimdInt32 {
+	using Type = std::int32_t;
+	using Reg = __m128i;
+	static constexpr int lanes = 4;
+
+	static Reg set(std::int32_t v0, std::int32_t v1, std::int32_t v2, std::int32_t v3) { return _mm_setr_epi32(v0, v1, v2, v3); }
+	static void store(std::int32_t* dst, Reg reg) { _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), reg); }
+	static Reg min(Reg a, Reg b) { return _mm_min_epi32(a, b); }
+	static Reg max(Reg a, Reg b) { return _mm_max_epi32(a, b); }
+};
+#endif
+
+template<class Simd>
+struct SimdCompareExchange {
+	template<class Reg>
+	SORTING_NETWORK_INLINE_OPTIMISED static void apply(Reg& a, Reg& b) {
+		const Reg lo = Simd::min(a, b);
+		b = Simd::max(a, b);
+		a = lo;
+	}
+};
+
+// SimdSort
+// sorts Simd::lanes arrays at once, element k of every array shares one register
+
+template<class T, class = void>
+struct SimdSort {
+	static constexpr bool enabled = false;
+};
+
+#ifdef SORTING_NETWORK_SIMD_FLOAT
+template<>
+struct SimdSort<float> : SimdFloat {
+	static constexpr bool enabled = true;
+};
+#endif
+
+#ifdef SORTING_NETWORK_SIMD_INT32
+template<>
+struct SimdSort<std::int32_t> : SimdInt32 {
+	static constexpr bool enabled = true;
+};
+#endif
+
+template<class Simd, std::size_t N>
+void sortNetworkLanes(std::array<typename Simd::Type, N>* arrs) {
+	typename Simd::Reg regs[N];
+	for (std::size_t k = 0; k < N; ++k) {
+		regs[k] = Simd::set(arrs[0][k], arrs[1][k], arrs[2][k], arrs[3][k]);
+	}
+	applyNetwork<SimdCompareExchange<Simd>, SortingNetworkT<N>>(regs);
+	for (std::size_t k = 0; k < N; ++k) {
+		typename Simd::Type lanes[Simd::lanes];
+		Simd::store(lanes, regs[k]);
+		for (int l = 0; l < Simd::lanes; ++l) {
+			arrs[l][k] = lanes[l];
+		}
+	}
+}
+
+// sortNetwork batch
+
+template<class T, std::size_t N>
+void sortNetwork(std::array<T, N>* arrs, std::size_t count) {
+	std::size_t i = 0;
+	if constexpr (SimdSort<T>::enabled) {
+		for (; i + SimdSort<T>::lanes <= count; i += SimdSort<T>::lanes) {
+			sortNetworkLanes<SimdSort<T>>(arrs + i);
+		}
+	}
+	for (; i < count; ++i) {
+		sortNetwork(arrs[i]);
+	}
+}